@@ -46,7 +46,8 @@ public class AdvancedVR : ModuleRules
 				"Slate",
 				"SlateCore",
                 "Projects",
-                "AppFramework"
+                "AppFramework",
+                "ImageWrapper"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -57,10 +58,17 @@ public class AdvancedVR : ModuleRules
                 new string[]
                 {
 					"DeveloperToolSettings",
-                    "PropertyEditor"
+                    "ImageCore",
+                    "PropertyEditor",
+                    "UnrealEd"
                 }
             );
         }
+        else
+        {
+            // Thumbnail atlas written by the cook, see FAdvancedVRThumbnailAtlas
+            RuntimeDependencies.Add("$(ProjectDir)/Intermediate/AdvancedVR/Thumbnails.avrt", StagedFileType.UFS);
+        }
 
         DynamicallyLoadedModuleNames.AddRange(
 			new string[]
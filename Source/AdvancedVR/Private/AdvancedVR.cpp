@@ -1,15 +1,34 @@
 #include "AdvancedVR.h"
+#include "AdvancedVRMemoryTracker.h"
 #include "AdvancedVRSettings.h"
+#include "AdvancedVRSettingsReloader.h"
+#include "AdvancedVRThumbnailCache.h"
 #if WITH_EDITOR
 #include "AdvancedVRSettingsCustomization.h"
 #endif
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
 #include "ISettingsContainer.h"
 #include "ISettingsModule.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Parse.h"
 
 #define LOCTEXT_NAMESPACE "FAdvancedVRModule"
 
+DEFINE_LOG_CATEGORY(LogAdvancedVR);
+
+LLM_DEFINE_TAG(AdvancedVR);
+LLM_DEFINE_TAG(AdvancedVR_Settings);
+LLM_DEFINE_TAG(AdvancedVR_MemoryTracker);
+LLM_DEFINE_TAG(AdvancedVR_Thumbnails);
+
 void FAdvancedVRModule::StartupModule()
 {
+    LLM_SCOPE_BYTAG(AdvancedVR);
+    const double StartTime = FPlatformTime::Seconds();
+
     if (ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
     {
         ISettingsContainerPtr SettingsContainer = SettingsModule->GetContainer("Project");
@@ -20,12 +39,73 @@ void FAdvancedVRModule::StartupModule()
             GetMutableDefault<UAdvancedVRSettings>());
     }
 
+    // Everything else waits until the engine is up, so it stays off the boot critical path.
+    // If the module is loaded late (e.g. enabled in a running editor) do it right away.
+    if (GEngine && GEngine->IsInitialized())
+    {
+        OnPostEngineInit();
+    }
+    else
+    {
+        PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddRaw(this, &FAdvancedVRModule::OnPostEngineInit);
+    }
+
+    UE_LOG(LogAdvancedVR, Log, TEXT("StartupModule took %.2f ms"), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void FAdvancedVRModule::OnPostEngineInit()
+{
+    FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+    PostEngineInitHandle.Reset();
+
+    LLM_SCOPE_BYTAG(AdvancedVR);
+
+#if WITH_ADVANCEDVR_MEMORY_TRACKER
+    // The enable callback may have been skipped if the cvar was set from ini before the module loaded
+    const IConsoleVariable* MemoryTrackerEnable = IConsoleManager::Get().FindConsoleVariable(TEXT("AdvancedVR.MemoryTracker.Enable"));
+    if (MemoryTrackerEnable && MemoryTrackerEnable->GetBool())
+    {
+        FAdvancedVRMemoryTracker::Get().Start();
+    }
+#endif
+
+#if WITH_ADVANCEDVR_SETTINGS_RELOAD
+    const IConsoleVariable* SettingsReloadEnable = IConsoleManager::Get().FindConsoleVariable(TEXT("AdvancedVR.SettingsReload.Enable"));
+    if ((SettingsReloadEnable && SettingsReloadEnable->GetBool()) || FParse::Param(FCommandLine::Get(), TEXT("AdvancedVRSettingsReload")))
+    {
+        FAdvancedVRSettingsReloader::Get().Start();
+    }
+#endif
+
 #if WITH_EDITOR
-    if (UAdvancedVRSettings* AdvancedVRSettings = GetMutableDefault<UAdvancedVRSettings>())
+    const double StartTime = FPlatformTime::Seconds();
+
+    // MapsToCook and the thumbnail atlas only matter to the cooker, and edits in the editor already
+    // keep MapsToCook in sync through PostEditChangeProperty. Packaging spawns a cook commandlet, so
+    // sync there instead of rewriting config files on every editor boot.
+    if (IsRunningCookCommandlet())
+    {
+        if (UAdvancedVRSettings* AdvancedVRSettings = GetMutableDefault<UAdvancedVRSettings>())
+        {
+            AdvancedVRSettings->SyncMapsToCook();
+        }
+
+        FAdvancedVRThumbnailAtlas::Build(UAdvancedVRSettings::GetPackagedGames(), FAdvancedVRThumbnailAtlas::GetFilename());
+    }
+
+    // Commandlets never show the settings panel
+    if (GIsEditor && !IsRunningCommandlet())
     {
-        AdvancedVRSettings->SyncMapsToCook();
+        RegisterEditorCustomization();
     }
 
+    UE_LOG(LogAdvancedVR, Log, TEXT("Deferred editor setup took %.2f ms"), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+#endif
+}
+
+#if WITH_EDITOR
+void FAdvancedVRModule::RegisterEditorCustomization()
+{
     FPropertyEditorModule& PropertyEditorModule = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor");
     PropertyEditorModule.RegisterCustomClassLayout(
         "AdvancedVRSettings",
@@ -33,22 +113,37 @@ void FAdvancedVRModule::StartupModule()
     );
 
     PropertyEditorModule.NotifyCustomizationModuleChanged();
-#endif
+    bCustomizationRegistered = true;
 }
+#endif
 
 void FAdvancedVRModule::ShutdownModule()
 {
+    FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+    PostEngineInitHandle.Reset();
+
+#if WITH_ADVANCEDVR_MEMORY_TRACKER
+    FAdvancedVRMemoryTracker::Get().Stop();
+#endif
+
+#if WITH_ADVANCEDVR_SETTINGS_RELOAD
+    FAdvancedVRSettingsReloader::Get().Stop();
+#endif
+
+    FAdvancedVRThumbnailCache::Shutdown();
+
     if (ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
     {
         SettingsModule->UnregisterSettings("Project", "Plugins", "AdvancedVR");
     }
 
 #if WITH_EDITOR
-    if (FModuleManager::Get().IsModuleLoaded("PropertyEditor"))
+    if (bCustomizationRegistered && FModuleManager::Get().IsModuleLoaded("PropertyEditor"))
     {
         FPropertyEditorModule& PropertyEditorModule = FModuleManager::GetModuleChecked<FPropertyEditorModule>("PropertyEditor");
         PropertyEditorModule.UnregisterCustomClassLayout("AdvancedVRSettings");
     }
+    bCustomizationRegistered = false;
 #endif
 }
 
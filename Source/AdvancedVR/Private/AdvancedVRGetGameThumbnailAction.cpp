@@ -0,0 +1,104 @@
+#include "AdvancedVRGetGameThumbnailAction.h"
+#include "AdvancedVRThumbnailCache.h"
+
+UAdvancedVRGetGameThumbnailAction* UAdvancedVRGetGameThumbnailAction::GetGameThumbnailAsync(UObject* WorldContextObject, const FString& MapName)
+{
+	UAdvancedVRGetGameThumbnailAction* Action = NewObject<UAdvancedVRGetGameThumbnailAction>();
+	Action->MapName = MapName;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UAdvancedVRGetGameThumbnailAction::Activate()
+{
+	FAdvancedVRThumbnailCache* Cache = FAdvancedVRThumbnailCache::Get();
+	if (!Cache || MapName.IsEmpty())
+	{
+		Finish(nullptr);
+		return;
+	}
+
+	// Bind first, the request can finish right away when the game has no thumbnail
+	ThumbnailCache = Cache->AsShared();
+	ThumbnailReadyHandle = Cache->OnThumbnailReady.AddUObject(this, &UAdvancedVRGetGameThumbnailAction::OnThumbnailReady);
+	Request();
+}
+
+void UAdvancedVRGetGameThumbnailAction::SetReadyToDestroy()
+{
+	if (TSharedPtr<FAdvancedVRThumbnailCache, ESPMode::ThreadSafe> Cache = ThumbnailCache.Pin())
+	{
+		Cache->OnThumbnailReady.Remove(ThumbnailReadyHandle);
+	}
+	ThumbnailCache.Reset();
+	ThumbnailReadyHandle.Reset();
+
+	Super::SetReadyToDestroy();
+}
+
+void UAdvancedVRGetGameThumbnailAction::Request()
+{
+	TSharedPtr<FAdvancedVRThumbnailCache, ESPMode::ThreadSafe> Cache = ThumbnailCache.Pin();
+	if (!Cache.IsValid())
+	{
+		Finish(nullptr);
+		return;
+	}
+
+	if (UTexture2D* Thumbnail = Cache->FindOrRequest(MapName))
+	{
+		Finish(Thumbnail);
+	}
+	else if (Cache->IsMissing(MapName))
+	{
+		Finish(nullptr);
+	}
+}
+
+void UAdvancedVRGetGameThumbnailAction::OnThumbnailReady(const FString& ReadyMapName, UTexture2D* Thumbnail)
+{
+	if (bFinished)
+	{
+		return;
+	}
+
+	if (ReadyMapName != MapName)
+	{
+		// Another request finished, so there is room in the queue again
+		if (bWaitingForSlot)
+		{
+			bWaitingForSlot = false;
+			Request();
+		}
+		return;
+	}
+
+	TSharedPtr<FAdvancedVRThumbnailCache, ESPMode::ThreadSafe> Cache = ThumbnailCache.Pin();
+	if (Thumbnail || !Cache.IsValid() || Cache->IsMissing(MapName))
+	{
+		Finish(Thumbnail);
+		return;
+	}
+
+	// Dropped for newer requests, requesting again here would only drop another one
+	bWaitingForSlot = true;
+}
+
+void UAdvancedVRGetGameThumbnailAction::Finish(UTexture2D* Thumbnail)
+{
+	if (bFinished)
+	{
+		return;
+	}
+	bFinished = true;
+
+	if (Thumbnail)
+	{
+		Completed.Broadcast(Thumbnail);
+	}
+	else
+	{
+		Failed.Broadcast(nullptr);
+	}
+	SetReadyToDestroy();
+}
@@ -0,0 +1,314 @@
+
+#include "AdvancedVRMemoryTracker.h"
+
+#if WITH_ADVANCEDVR_MEMORY_TRACKER
+
+#include "AdvancedVR.h"
+#include "AdvancedVRSettings.h"
+#include "AdvancedVRSettingsSnapshot.h"
+#include "Engine/Engine.h"
+#include "Engine/StreamableRenderAsset.h"
+#include "Engine/Texture.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Sound/SoundWave.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectIterator.h"
+
+static TAutoConsoleVariable<bool> CVarMemoryTrackerEnable(
+	TEXT("AdvancedVR.MemoryTracker.Enable"),
+	false,
+	TEXT("Attribute loaded packages, textures, meshes and sounds to the AdvancedVR game whose map loaded them."),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable* Variable)
+	{
+		if (Variable->GetBool())
+		{
+			FAdvancedVRMemoryTracker::Get().Start();
+		}
+		else
+		{
+			FAdvancedVRMemoryTracker::Get().Stop();
+		}
+	}),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMemoryTrackerInterval(
+	TEXT("AdvancedVR.MemoryTracker.Interval"),
+	5.0f,
+	TEXT("Seconds between two samples of the AdvancedVR memory tracker."),
+	ECVF_Default);
+
+static FAutoConsoleCommand MemoryTrackerReportCommand(
+	TEXT("AdvancedVR.MemoryTracker.Report"),
+	TEXT("Log tracked texture, mesh and sound memory per AdvancedVR game."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FAdvancedVRMemoryTracker& Tracker = FAdvancedVRMemoryTracker::Get();
+		if (Tracker.IsRunning())
+		{
+			Tracker.Sample();
+		}
+		Tracker.LogReport();
+	}));
+
+static FAutoConsoleCommand MemoryTrackerExportCsvCommand(
+	TEXT("AdvancedVR.MemoryTracker.ExportCsv"),
+	TEXT("Write tracked texture, mesh and sound memory per AdvancedVR game to a CSV file. Defaults to the profiling directory."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		FAdvancedVRMemoryTracker& Tracker = FAdvancedVRMemoryTracker::Get();
+		if (Tracker.IsRunning())
+		{
+			Tracker.Sample();
+		}
+
+		const FString Filename = Args.Num() > 0
+			? Args[0]
+			: FPaths::Combine(FPaths::ProfilingDir(), TEXT("AdvancedVR"), FString::Printf(TEXT("GameMemory-%s.csv"), *FDateTime::Now().ToString()));
+		Tracker.ExportCsv(Filename);
+	}));
+
+FAdvancedVRMemoryTracker& FAdvancedVRMemoryTracker::Get()
+{
+	static FAdvancedVRMemoryTracker Tracker;
+	return Tracker;
+}
+
+void FAdvancedVRMemoryTracker::Start()
+{
+	check(IsInGameThread());
+
+	// Commandlets never play a game map
+	if (bRunning || IsRunningCommandlet())
+	{
+		return;
+	}
+
+	LLM_SCOPE_BYTAG(AdvancedVR_MemoryTracker);
+
+	GameMemory.Reset();
+	Attribution.Reset();
+
+	// Entry 0 collects everything loaded outside of a game map (startup, lobby, shared assets)
+	GameMemory.AddDefaulted();
+	for (const FGameBuildConfig& GameBuildConfig : UAdvancedVRSettings::GetSnapshot()->PackagedGames)
+	{
+		GameMemory.AddDefaulted_GetRef().MapName = GameBuildConfig.MapName;
+	}
+	CurrentGameIndex = 0;
+
+	// The tracker can be enabled while a game map is already playing, so that game owns what is loaded now
+	if (GEngine)
+	{
+		for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+		{
+			const UWorld* World = WorldContext.World();
+			if (World && (WorldContext.WorldType == EWorldType::Game || WorldContext.WorldType == EWorldType::PIE))
+			{
+				CurrentGameIndex = FindOrAddGameForMap(UWorld::RemovePIEPrefix(World->GetOutermost()->GetName()));
+				if (CurrentGameIndex != 0)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddRaw(this, &FAdvancedVRMemoryTracker::OnPreLoadMap);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FAdvancedVRMemoryTracker::OnPostLoadMapWithWorld);
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FAdvancedVRMemoryTracker::Tick), FMath::Max(CVarMemoryTrackerInterval.GetValueOnGameThread(), 0.1f));
+
+	bRunning = true;
+	UE_LOG(LogAdvancedVR, Log, TEXT("Memory tracker started for %d games, current game %s"), GameMemory.Num() - 1,
+		GameMemory[CurrentGameIndex].MapName.IsEmpty() ? TEXT("<Unattributed>") : *GameMemory[CurrentGameIndex].MapName);
+
+	// Whatever is already loaded belongs to the current game, or to no game outside of a game map
+	Sample();
+}
+
+void FAdvancedVRMemoryTracker::Stop()
+{
+	check(IsInGameThread());
+
+	if (!bRunning)
+	{
+		return;
+	}
+
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	PreLoadMapHandle.Reset();
+	PostLoadMapHandle.Reset();
+	TickerHandle.Reset();
+
+	// Keep GameMemory so the last results can still be reported
+	Attribution.Empty();
+	bRunning = false;
+	UE_LOG(LogAdvancedVR, Log, TEXT("Memory tracker stopped"));
+}
+
+void FAdvancedVRMemoryTracker::Sample()
+{
+	check(IsInGameThread());
+	LLM_SCOPE_BYTAG(AdvancedVR_MemoryTracker);
+
+	for (FAdvancedVRGameMemory& Game : GameMemory)
+	{
+		Game.NumPackages = Game.NumTextures = Game.NumMeshes = Game.NumSounds = 0;
+		Game.TextureBytes = Game.MeshBytes = Game.SoundBytes = 0;
+	}
+
+	// Rebuilt from live objects only, so unloaded objects drop out of the attribution
+	TMap<FObjectKey, int32> NewAttribution;
+	NewAttribution.Reserve(Attribution.Num());
+
+	auto Attribute = [this, &NewAttribution](const UObject* Object) -> FAdvancedVRGameMemory&
+	{
+		const FObjectKey Key(Object);
+		const int32* ExistingIndex = Attribution.Find(Key);
+		const int32 GameIndex = ExistingIndex ? *ExistingIndex : CurrentGameIndex;
+		NewAttribution.Add(Key, GameIndex);
+		return GameMemory[GameIndex];
+	};
+
+	for (TObjectIterator<UPackage> It; It; ++It)
+	{
+		Attribute(*It).NumPackages++;
+	}
+
+	// Exclusive sizes only count the mips and LODs that are streamed in, not the full asset
+	for (TObjectIterator<UStreamableRenderAsset> It(RF_ClassDefaultObject); It; ++It)
+	{
+		FAdvancedVRGameMemory& Game = Attribute(*It);
+		const int64 Bytes = It->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		if (It->IsA<UTexture>())
+		{
+			Game.NumTextures++;
+			Game.TextureBytes += Bytes;
+		}
+		else
+		{
+			Game.NumMeshes++;
+			Game.MeshBytes += Bytes;
+		}
+	}
+
+	for (TObjectIterator<USoundWave> It(RF_ClassDefaultObject); It; ++It)
+	{
+		FAdvancedVRGameMemory& Game = Attribute(*It);
+		Game.NumSounds++;
+		Game.SoundBytes += It->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	}
+
+	Attribution = MoveTemp(NewAttribution);
+
+	for (FAdvancedVRGameMemory& Game : GameMemory)
+	{
+		Game.PeakTrackedBytes = FMath::Max(Game.PeakTrackedBytes, Game.GetTrackedBytes());
+	}
+}
+
+void FAdvancedVRMemoryTracker::LogReport() const
+{
+	UE_LOG(LogAdvancedVR, Display, TEXT("%-32s %12s %12s %12s %12s %12s %8s %8s %8s %8s"),
+		TEXT("Game"), TEXT("Tracked MB"), TEXT("Peak MB"), TEXT("Texture MB"), TEXT("Mesh MB"), TEXT("Sound MB"),
+		TEXT("Packages"), TEXT("Textures"), TEXT("Meshes"), TEXT("Sounds"));
+
+	for (const FAdvancedVRGameMemory& Game : GameMemory)
+	{
+		UE_LOG(LogAdvancedVR, Display, TEXT("%-32s %12.2f %12.2f %12.2f %12.2f %12.2f %8d %8d %8d %8d"),
+			Game.MapName.IsEmpty() ? TEXT("<Unattributed>") : *Game.MapName,
+			Game.GetTrackedBytes() / (1024.0 * 1024.0),
+			Game.PeakTrackedBytes / (1024.0 * 1024.0),
+			Game.TextureBytes / (1024.0 * 1024.0),
+			Game.MeshBytes / (1024.0 * 1024.0),
+			Game.SoundBytes / (1024.0 * 1024.0),
+			Game.NumPackages,
+			Game.NumTextures,
+			Game.NumMeshes,
+			Game.NumSounds);
+	}
+}
+
+bool FAdvancedVRMemoryTracker::ExportCsv(const FString& Filename) const
+{
+	FString Csv = TEXT("Game,TrackedBytes,PeakTrackedBytes,TextureBytes,MeshBytes,SoundBytes,Packages,Textures,Meshes,Sounds\n");
+	for (const FAdvancedVRGameMemory& Game : GameMemory)
+	{
+		Csv += FString::Printf(TEXT("%s,%lld,%lld,%lld,%lld,%lld,%d,%d,%d,%d\n"),
+			Game.MapName.IsEmpty() ? TEXT("<Unattributed>") : *Game.MapName,
+			Game.GetTrackedBytes(),
+			Game.PeakTrackedBytes,
+			Game.TextureBytes,
+			Game.MeshBytes,
+			Game.SoundBytes,
+			Game.NumPackages,
+			Game.NumTextures,
+			Game.NumMeshes,
+			Game.NumSounds);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *Filename))
+	{
+		UE_LOG(LogAdvancedVR, Error, TEXT("Failed to write memory report to %s"), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogAdvancedVR, Log, TEXT("Wrote memory report to %s"), *Filename);
+	return true;
+}
+
+void FAdvancedVRMemoryTracker::OnPreLoadMap(const FString& MapName)
+{
+	// Close the books on the previous game before the new map starts loading
+	Sample();
+	CurrentGameIndex = FindOrAddGameForMap(UWorld::RemovePIEPrefix(MapName));
+}
+
+void FAdvancedVRMemoryTracker::OnPostLoadMapWithWorld(UWorld* World)
+{
+	if (World)
+	{
+		CurrentGameIndex = FindOrAddGameForMap(UWorld::RemovePIEPrefix(World->GetOutermost()->GetName()));
+	}
+	Sample();
+}
+
+bool FAdvancedVRMemoryTracker::Tick(float DeltaTime)
+{
+	Sample();
+	return true;
+}
+
+int32 FAdvancedVRMemoryTracker::FindOrAddGameForMap(const FString& MapPackageName)
+{
+	const FString PackageName = FPackageName::ObjectPathToPackageName(MapPackageName);
+
+	for (const FGameBuildConfig& GameBuildConfig : UAdvancedVRSettings::GetSnapshot()->AllGames)
+	{
+		const FString GamePackageName = FPackageName::ObjectPathToPackageName(GameBuildConfig.MapPath.FilePath);
+		if (GamePackageName.IsEmpty() || (GamePackageName != PackageName && FPackageName::GetShortName(GamePackageName) != PackageName))
+		{
+			continue;
+		}
+
+		const int32 ExistingIndex = GameMemory.IndexOfByPredicate([&GameBuildConfig](const FAdvancedVRGameMemory& Game) { return Game.MapName == GameBuildConfig.MapName; });
+		if (ExistingIndex != INDEX_NONE)
+		{
+			return ExistingIndex;
+		}
+
+		const int32 NewIndex = GameMemory.AddDefaulted();
+		GameMemory[NewIndex].MapName = GameBuildConfig.MapName;
+		return NewIndex;
+	}
+
+	return 0;
+}
+
+#endif // WITH_ADVANCEDVR_MEMORY_TRACKER
@@ -1,8 +1,17 @@
 
 #include "AdvancedVRSettings.h"
+#include "AdvancedVR.h"
+#include "AdvancedVRSettingsSnapshot.h"
+#include "AdvancedVRThumbnailCache.h"
 
+#include <atomic>
+
+#include "Containers/Ticker.h"
+#include "HAL/FileManager.h"
+#include "Misc/ConfigCacheIni.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "UObject/Package.h"
 #include "Interfaces/IProjectManager.h"
 #if WITH_EDITOR
 #include "Settings/ProjectPackagingSettings.h"
@@ -11,13 +20,90 @@
 DEFINE_LOG_CATEGORY(LogAdvancedVRSettings);
 
 TMulticastDelegate<void()> UAdvancedVRSettings::OnSettingsUpdated;
+FOnAdvancedVRSettingsChanged UAdvancedVRSettings::OnSettingsChanged;
+
+namespace
+{
+	// Latest snapshot, read lock-free from any thread. CurrentSnapshotRef keeps it alive, game thread only.
+	std::atomic<const FAdvancedVRSettingsSnapshot*> CurrentSnapshot{ nullptr };
+	TSharedPtr<const FAdvancedVRSettingsSnapshot, ESPMode::ThreadSafe> CurrentSnapshotRef;
+
+	// A reader may have loaded the raw pointer of a replaced snapshot but not yet taken a reference to it,
+	// so replaced snapshots are only released after a few frames and at least a second. Game thread only.
+	constexpr uint64 SnapshotRetireFrames = 3;
+	constexpr double SnapshotRetireSeconds = 1.0;
+
+	struct FRetiredSnapshot
+	{
+		FAdvancedVRSettingsSnapshotRef Snapshot;
+		uint64 Frame;
+		double Time;
+	};
+	TArray<FRetiredSnapshot> RetiredSnapshots;
+	FTSTicker::FDelegateHandle RetireTickerHandle;
+
+	bool ReleaseRetiredSnapshots(float DeltaTime)
+	{
+		const double Now = FPlatformTime::Seconds();
+		RetiredSnapshots.RemoveAll([Now](const FRetiredSnapshot& Retired)
+		{
+			return GFrameCounter >= Retired.Frame + SnapshotRetireFrames && Now >= Retired.Time + SnapshotRetireSeconds;
+		});
+
+		if (RetiredSnapshots.IsEmpty())
+		{
+			RetireTickerHandle.Reset();
+			return false;
+		}
+		return true;
+	}
+
+	void RetireSnapshot(FAdvancedVRSettingsSnapshotRef Snapshot)
+	{
+		RetiredSnapshots.Add({ MoveTemp(Snapshot), GFrameCounter, FPlatformTime::Seconds() });
+		if (!RetireTickerHandle.IsValid())
+		{
+			RetireTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&ReleaseRetiredSnapshots));
+		}
+	}
+
+	// Set while a publish requested by PostReloadConfig is waiting for the next tick
+	bool bDeferredPublishPending = false;
+
+	// Config properties and the change each one reports, shared by editor edits and live reloads
+	const TPair<FName, EAdvancedVRSettingsChange> ConfigPropertyChanges[] =
+	{
+		{ GET_MEMBER_NAME_CHECKED(UAdvancedVRSettings, PlatformType), EAdvancedVRSettingsChange::PlatformType },
+		{ GET_MEMBER_NAME_CHECKED(UAdvancedVRSettings, XRComponentClass), EAdvancedVRSettingsChange::XRComponentClass },
+		{ GET_MEMBER_NAME_CHECKED(UAdvancedVRSettings, AllGameMaps), EAdvancedVRSettingsChange::AllGameMaps },
+		{ GET_MEMBER_NAME_CHECKED(UAdvancedVRSettings, MapsToPackage), EAdvancedVRSettingsChange::MapsToPackage }
+	};
+
+	EAdvancedVRSettingsChange GetConfigPropertyChange(FName PropertyName)
+	{
+		for (const TPair<FName, EAdvancedVRSettingsChange>& ConfigPropertyChange : ConfigPropertyChanges)
+		{
+			if (ConfigPropertyChange.Key == PropertyName)
+			{
+				return ConfigPropertyChange.Value;
+			}
+		}
+		return EAdvancedVRSettingsChange::None;
+	}
+}
 
 UAdvancedVRSettings::UAdvancedVRSettings(const FObjectInitializer& ObjectInitializer)
-	: Super(ObjectInitializer),
-	PlatformType(EPlatformType::Unknown),
-	XRComponentClass(UBaseXRComponent::StaticClass())
+	: Super(ObjectInitializer)
 {
-	
+	ResetConfigToDefaults();
+}
+
+void UAdvancedVRSettings::ResetConfigToDefaults()
+{
+	PlatformType = EPlatformType::Unknown;
+	XRComponentClass = UBaseXRComponent::StaticClass();
+	AllGameMaps.Reset();
+	MapsToPackage.Reset();
 }
 
 FString UAdvancedVRSettings::GetPlatformTypeAsString(EPlatformType Platform)
@@ -36,54 +122,140 @@ FString UAdvancedVRSettings::GetPlatformTypeAsString(EPlatformType Platform)
 
 EPlatformType UAdvancedVRSettings::GetPlatformType()
 {
-	const UAdvancedVRSettings* AdvancedVRSettings = GetDefault<UAdvancedVRSettings>();
-	return AdvancedVRSettings->PlatformType;
+	return GetSnapshot()->PlatformType;
 }
 
 
 TSoftClassPtr<UBaseXRComponent> UAdvancedVRSettings::GetXRComponentClass()
 {
-	const UAdvancedVRSettings* AdvancedVRSettings = GetDefault<UAdvancedVRSettings>();
-	return AdvancedVRSettings->XRComponentClass;
+	return TSoftClassPtr<UBaseXRComponent>(GetSnapshot()->XRComponentClassPath);
 }
 
 TArray<FGameBuildConfig> UAdvancedVRSettings::GetAllGames()
 {
-	TArray<FString> AllMapNames;
-	const UAdvancedVRSettings* AdvancedVRSettings = GetDefault<UAdvancedVRSettings>();
-	return AdvancedVRSettings->AllGameMaps;
+	return GetSnapshot()->AllGames;
 }
 
 TArray<FString> UAdvancedVRSettings::GetAllMapNames()
 {
-	TArray<FString> AllMapNames;
-	const UAdvancedVRSettings* AdvancedVRSettings = GetDefault<UAdvancedVRSettings>();
-	for (const FGameBuildConfig& GameBuildConfig : AdvancedVRSettings->AllGameMaps)
+	return GetSnapshot()->AllMapNames;
+}
+
+TArray<FGameBuildConfig> UAdvancedVRSettings::GetPackagedGames()
+{
+	return GetSnapshot()->PackagedGames;
+}
+
+TArray<FString> UAdvancedVRSettings::GetPackagedMapNames()
+{
+	return GetSnapshot()->PackagedMapNames;
+}
+
+UTexture2D* UAdvancedVRSettings::GetGameThumbnail(const FString& MapName)
+{
+	FAdvancedVRThumbnailCache* ThumbnailCache = FAdvancedVRThumbnailCache::Get();
+	return ThumbnailCache ? ThumbnailCache->FindOrRequest(MapName) : nullptr;
+}
+
+FAdvancedVRSettingsSnapshotRef UAdvancedVRSettings::GetSnapshot()
+{
+	if (const FAdvancedVRSettingsSnapshot* Snapshot = CurrentSnapshot.load(std::memory_order_acquire))
 	{
-		AllMapNames.Add(GameBuildConfig.MapName);
+		return Snapshot->AsShared();
 	}
-	return AllMapNames;
+	return FAdvancedVRSettingsSnapshot::GetEmpty();
 }
 
-TArray<FGameBuildConfig> UAdvancedVRSettings::GetPackagedGames()
+void UAdvancedVRSettings::PublishSnapshot()
 {
-	const UAdvancedVRSettings* AdvancedVRSettings = GetDefault<UAdvancedVRSettings>();
-	TArray<FGameBuildConfig> GameBuildConfigArray;
-	for (const FString& Map : AdvancedVRSettings->MapsToPackage)
+	check(IsInGameThread());
+
+	if (!HasAnyFlags(RF_ClassDefaultObject))
 	{
-		FGameBuildConfig GameBuildConfig;
-		if (GetGameBuildConfigByMapName(AdvancedVRSettings, Map, GameBuildConfig))
-		{
-			GameBuildConfigArray.Add(GameBuildConfig);
-		}
+		return;
+	}
+
+	// Edits and reloads often leave the values as they were
+	if (GetSnapshot()->Matches(*this))
+	{
+		return;
+	}
+
+	LLM_SCOPE_BYTAG(AdvancedVR_Settings);
+
+	FAdvancedVRSettingsSnapshotRef Snapshot = FAdvancedVRSettingsSnapshot::Create(*this);
+	CurrentSnapshot.store(&Snapshot.Get(), std::memory_order_release);
+
+	if (CurrentSnapshotRef.IsValid())
+	{
+		RetireSnapshot(CurrentSnapshotRef.ToSharedRef());
 	}
-	return GameBuildConfigArray;
+	CurrentSnapshotRef = Snapshot;
+
+	UE_LOG(LogAdvancedVRSettings, Verbose, TEXT("Published settings snapshot %u"), Snapshot->Version);
 }
 
-TArray<FString> UAdvancedVRSettings::GetPackagedMapNames()
+EAdvancedVRSettingsChange UAdvancedVRSettings::ReloadConfigWithOverride(const FString& OverrideFilename)
 {
-	const UAdvancedVRSettings* AdvancedVRSettings = GetDefault<UAdvancedVRSettings>();
-	return AdvancedVRSettings->MapsToPackage;
+	check(IsInGameThread());
+	check(HasAnyFlags(RF_ClassDefaultObject));
+
+	// Rebuild the whole Engine hierarchy (Base, Default and platform layers) from disk,
+	// so per-platform values such as PlatformType survive the reload
+	FConfigFile EngineConfig;
+	FConfigCacheIni::LoadExternalIniFile(EngineConfig, TEXT("Engine"), *FPaths::EngineConfigDir(), *FPaths::SourceConfigDir(), true, nullptr, true);
+
+	// Combine applies the +, -, . and ! array operators the same way the hierarchy does
+	if (!OverrideFilename.IsEmpty() && IFileManager::Get().FileExists(*OverrideFilename))
+	{
+		EngineConfig.Combine(OverrideFilename);
+		// Warning so a stale override on a device stands out in its log
+		UE_LOG(LogAdvancedVRSettings, Warning, TEXT("Applied settings override %s on top of the packaged settings"), *OverrideFilename);
+	}
+
+	// Start from the constructor values, so keys that are no longer in any file do not keep their old value
+	UAdvancedVRSettings* ReloadedSettings = NewObject<UAdvancedVRSettings>(GetTransientPackage(), NAME_None, RF_Transient);
+	ReloadedSettings->ResetConfigToDefaults();
+
+	// LoadConfig reads from GConfig, so register the rebuilt hierarchy under a temporary name
+	const FString ReloadConfigName = TEXT("AdvancedVRSettingsReload");
+	GConfig->Add(ReloadConfigName, EngineConfig);
+	ReloadedSettings->LoadConfig(nullptr, *ReloadConfigName);
+	GConfig->UnloadFile(ReloadConfigName);
+
+	const EAdvancedVRSettingsChange Changes = ApplySettingsFrom(*ReloadedSettings);
+	ReloadedSettings->MarkAsGarbage();
+	return Changes;
+}
+
+EAdvancedVRSettingsChange UAdvancedVRSettings::ApplySettingsFrom(const UAdvancedVRSettings& Source)
+{
+	EAdvancedVRSettingsChange Changes = EAdvancedVRSettingsChange::None;
+	for (const TPair<FName, EAdvancedVRSettingsChange>& ConfigProperty : ConfigPropertyChanges)
+	{
+		const FProperty* Property = GetClass()->FindPropertyByName(ConfigProperty.Key);
+		if (Property && !Property->Identical_InContainer(this, &Source))
+		{
+			UE_LOG(LogAdvancedVRSettings, Log, TEXT("Changed %s"), *ConfigProperty.Key.ToString());
+			Property->CopyCompleteValue_InContainer(this, &Source);
+			Changes |= ConfigProperty.Value;
+		}
+	}
+
+	if (Changes == EAdvancedVRSettingsChange::None)
+	{
+		return Changes;
+	}
+
+	PublishSnapshot();
+
+	if (EnumHasAnyFlags(Changes, EAdvancedVRSettingsChange::AllGameMaps))
+	{
+		OnSettingsUpdated.Broadcast();
+	}
+	OnSettingsChanged.Broadcast(Changes, GetSnapshot());
+
+	return Changes;
 }
 
 void UAdvancedVRSettings::PostInitProperties()
@@ -100,6 +272,36 @@ void UAdvancedVRSettings::PostInitProperties()
 #endif
 
 	Super::PostInitProperties();
+
+	PublishSnapshot();
+}
+
+void UAdvancedVRSettings::PostReloadConfig(FProperty* PropertyThatWasLoaded)
+{
+	Super::PostReloadConfig(PropertyThatWasLoaded);
+
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		return;
+	}
+
+	if (PropertyThatWasLoaded == nullptr)
+	{
+		PublishSnapshot();
+		return;
+	}
+
+	// Called once per reloaded property, publish once after the whole reload instead
+	if (!bDeferredPublishPending)
+	{
+		bDeferredPublishPending = true;
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float DeltaTime)
+		{
+			bDeferredPublishPending = false;
+			PublishSnapshot();
+			return false;
+		}));
+	}
 }
 
 #if WITH_EDITOR
@@ -112,10 +314,15 @@ void UAdvancedVRSettings::PostEditChangeProperty(FPropertyChangedEvent& Property
 
 	UE_LOG(LogAdvancedVRSettings, Log, TEXT("PropertyThatChanged: %s"), *PropertyThatChanged->GetFName().ToString());
 
+	// Publish before anything below reads the settings back through the static accessors
+	PublishSnapshot();
+
 	if (PropertyThatChanged != nullptr)
 	{
+		const EAdvancedVRSettingsChange Change = GetConfigPropertyChange(PropertyThatChanged->GetFName());
+
 #if WITH_EDITORONLY_DATA
-		if (PropertyThatChanged->GetFName() == GET_MEMBER_NAME_CHECKED(UAdvancedVRSettings, PlatformType))
+		if (Change == EAdvancedVRSettingsChange::PlatformType)
 		{
 			UE_LOG(LogAdvancedVRSettings, Log, TEXT("Changed To PlatformType: %s"), *UAdvancedVRSettings::GetPlatformTypeAsString(GetPlatformType()));
 
@@ -167,22 +374,27 @@ void UAdvancedVRSettings::PostEditChangeProperty(FPropertyChangedEvent& Property
 				UE_LOG(LogAdvancedVRSettings, Log, TEXT("Update Plugins In .uproject Successfully"));
 			}
 		}
-		else if (PropertyThatChanged->GetFName() == GET_MEMBER_NAME_CHECKED(UAdvancedVRSettings, XRComponentClass))
+		else if (Change == EAdvancedVRSettingsChange::XRComponentClass)
 		{
 			UE_LOG(LogAdvancedVRSettings, Log, TEXT("Changed To XRComponentClass: %s"), *GetXRComponentClass().ToString());
 		}
-		else if (PropertyThatChanged->GetFName() == GET_MEMBER_NAME_CHECKED(UAdvancedVRSettings, AllGameMaps))
+		else if (Change == EAdvancedVRSettingsChange::AllGameMaps)
 		{
 			UE_LOG(LogAdvancedVRSettings, Log, TEXT("Changed AllGameMaps"));
 			
 			OnSettingsUpdated.Broadcast();
 		}
-		else if (PropertyThatChanged->GetFName() == GET_MEMBER_NAME_CHECKED(UAdvancedVRSettings, MapsToPackage))
+		else if (Change == EAdvancedVRSettingsChange::MapsToPackage)
 		{
 			UE_LOG(LogAdvancedVRSettings, Log, TEXT("Changed MapToPackage"));
 			SyncMapsToCook();
 		}
 #endif
+
+		if (Change != EAdvancedVRSettingsChange::None)
+		{
+			OnSettingsChanged.Broadcast(Change, GetSnapshot());
+		}
 	}
 }
 #endif
@@ -217,6 +429,7 @@ void UAdvancedVRSettings::SyncMapsToCook()
 
 		// Replace MapsToPackage with only valid entries
 		MapsToPackage = ValidMapsToPackage;
+		PublishSnapshot();
 
 		// Log updated maps for debugging
 		for (const FFilePath& Map : PackagingSettings->MapsToCook)
@@ -0,0 +1,138 @@
+
+#include "AdvancedVRSettingsReloader.h"
+
+#if WITH_ADVANCEDVR_SETTINGS_RELOAD
+
+#include "AdvancedVR.h"
+#include "AdvancedVRSettings.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<bool> CVarSettingsReloadEnable(
+	TEXT("AdvancedVR.SettingsReload.Enable"),
+	false,
+	TEXT("Reload AdvancedVR settings when the config or override file changes. Debug and Development builds outside the editor only, also enabled by -AdvancedVRSettingsReload."),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable* Variable)
+	{
+		if (Variable->GetBool())
+		{
+			FAdvancedVRSettingsReloader::Get().Start();
+		}
+		else
+		{
+			FAdvancedVRSettingsReloader::Get().Stop();
+		}
+	}),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSettingsReloadInterval(
+	TEXT("AdvancedVR.SettingsReload.Interval"),
+	1.0f,
+	TEXT("Seconds between two checks of the AdvancedVR config files."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<FString> CVarSettingsReloadOverrideFile(
+	TEXT("AdvancedVR.SettingsReload.OverrideFile"),
+	TEXT(""),
+	TEXT("Config file applied on top of the AdvancedVR settings. Empty uses Saved/Config/AdvancedVROverride.ini."),
+	ECVF_Default);
+
+static FAutoConsoleCommand SettingsReloadNowCommand(
+	TEXT("AdvancedVR.SettingsReload.Now"),
+	TEXT("Re-read the AdvancedVR config and override files."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FAdvancedVRSettingsReloader::Get().ReloadNow();
+	}));
+
+FAdvancedVRSettingsReloader& FAdvancedVRSettingsReloader::Get()
+{
+	static FAdvancedVRSettingsReloader Reloader;
+	return Reloader;
+}
+
+FString FAdvancedVRSettingsReloader::GetOverrideFilename()
+{
+	const FString OverrideFilename = CVarSettingsReloadOverrideFile.GetValueOnGameThread();
+	return OverrideFilename.IsEmpty()
+		? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Config"), TEXT("AdvancedVROverride.ini"))
+		: OverrideFilename;
+}
+
+void FAdvancedVRSettingsReloader::Start()
+{
+	check(IsInGameThread());
+
+	// The editor already propagates changes through PostEditChangeProperty, and commandlets never need a reload
+	if (bRunning || GIsEditor || IsRunningCommandlet())
+	{
+		return;
+	}
+
+	WatchedFiles.Reset();
+	WatchedFiles.Add({ GetDefault<UAdvancedVRSettings>()->GetDefaultConfigFilename(), FDateTime::MinValue() });
+	WatchedFiles.Add({ GetOverrideFilename(), FDateTime::MinValue() });
+
+	// The default config is already loaded, only pick up later writes to it.
+	// Index 1 is the override file, applied on the first tick if it already exists.
+	WatchedFiles[0].TimeStamp = IFileManager::Get().GetTimeStamp(*WatchedFiles[0].Filename);
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FAdvancedVRSettingsReloader::Tick), FMath::Max(CVarSettingsReloadInterval.GetValueOnGameThread(), 0.1f));
+	bRunning = true;
+
+	UE_LOG(LogAdvancedVR, Log, TEXT("Watching %s and %s for settings changes"), *WatchedFiles[0].Filename, *WatchedFiles[1].Filename);
+}
+
+void FAdvancedVRSettingsReloader::Stop()
+{
+	check(IsInGameThread());
+
+	if (!bRunning)
+	{
+		return;
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+	WatchedFiles.Empty();
+	bRunning = false;
+}
+
+void FAdvancedVRSettingsReloader::ReloadNow()
+{
+	check(IsInGameThread());
+
+	const FString OverrideFilename = bRunning ? WatchedFiles[1].Filename : GetOverrideFilename();
+
+	const double StartTime = FPlatformTime::Seconds();
+	const EAdvancedVRSettingsChange Changes = GetMutableDefault<UAdvancedVRSettings>()->ReloadConfigWithOverride(OverrideFilename);
+
+	UE_LOG(LogAdvancedVR, Log, TEXT("Settings reload %s in %.2f ms"),
+		Changes == EAdvancedVRSettingsChange::None ? TEXT("found no changes") : TEXT("applied changes"),
+		(FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+bool FAdvancedVRSettingsReloader::Tick(float DeltaTime)
+{
+	bool bChanged = false;
+	for (FWatchedFile& WatchedFile : WatchedFiles)
+	{
+		// MinValue when the file does not exist, so deleting the override file reloads the config hierarchy without it
+		const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*WatchedFile.Filename);
+		if (TimeStamp != WatchedFile.TimeStamp)
+		{
+			WatchedFile.TimeStamp = TimeStamp;
+			bChanged = true;
+		}
+	}
+
+	if (bChanged)
+	{
+		ReloadNow();
+	}
+	return true;
+}
+
+#endif // WITH_ADVANCEDVR_SETTINGS_RELOAD
@@ -0,0 +1,62 @@
+
+#include "AdvancedVRSettingsSnapshot.h"
+
+FAdvancedVRSettingsSnapshotRef FAdvancedVRSettingsSnapshot::Create(const UAdvancedVRSettings& Settings)
+{
+	check(IsInGameThread());
+
+	static uint32 NextVersion = 1;
+
+	TSharedRef<FAdvancedVRSettingsSnapshot, ESPMode::ThreadSafe> Snapshot = MakeShared<FAdvancedVRSettingsSnapshot, ESPMode::ThreadSafe>();
+	Snapshot->Version = NextVersion++;
+	Snapshot->PlatformType = Settings.PlatformType;
+	Snapshot->XRComponentClassPath = FSoftClassPath(Settings.XRComponentClass.ToSoftObjectPath());
+	Snapshot->AllGames = Settings.AllGameMaps;
+
+	Snapshot->AllMapNames.Reserve(Settings.AllGameMaps.Num());
+	for (const FGameBuildConfig& GameBuildConfig : Settings.AllGameMaps)
+	{
+		Snapshot->AllMapNames.Add(GameBuildConfig.MapName);
+	}
+
+	Snapshot->PackagedMapNames = Settings.MapsToPackage;
+	for (const FString& Map : Settings.MapsToPackage)
+	{
+		if (const FGameBuildConfig* GameBuildConfig = Settings.AllGameMaps.FindByPredicate([&Map](const FGameBuildConfig& Game) { return Game.MapName.Equals(Map); }))
+		{
+			Snapshot->PackagedGames.Add(*GameBuildConfig);
+		}
+	}
+
+	return Snapshot;
+}
+
+FAdvancedVRSettingsSnapshotRef FAdvancedVRSettingsSnapshot::GetEmpty()
+{
+	static const FAdvancedVRSettingsSnapshotRef EmptySnapshot = MakeShared<FAdvancedVRSettingsSnapshot, ESPMode::ThreadSafe>();
+	return EmptySnapshot;
+}
+
+bool FAdvancedVRSettingsSnapshot::Matches(const UAdvancedVRSettings& Settings) const
+{
+	check(IsInGameThread());
+
+	if (Version == 0
+		|| PlatformType != Settings.PlatformType
+		|| XRComponentClassPath != FSoftClassPath(Settings.XRComponentClass.ToSoftObjectPath())
+		|| PackagedMapNames != Settings.MapsToPackage
+		|| AllGames.Num() != Settings.AllGameMaps.Num())
+	{
+		return false;
+	}
+
+	UScriptStruct* GameBuildConfigStruct = FGameBuildConfig::StaticStruct();
+	for (int32 Index = 0; Index < AllGames.Num(); ++Index)
+	{
+		if (!GameBuildConfigStruct->CompareScriptStruct(&AllGames[Index], &Settings.AllGameMaps[Index], PPF_None))
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,564 @@
+
+#include "AdvancedVRThumbnailCache.h"
+#include "AdvancedVR.h"
+#include "AdvancedVRSettingsSnapshot.h"
+
+#include "Async/Async.h"
+#include "Engine/Texture2D.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+#if WITH_EDITOR
+#include "ImageCore.h"
+#include "ObjectTools.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
+#endif
+
+static TAutoConsoleVariable<int32> CVarThumbnailCacheSize(
+	TEXT("AdvancedVR.Thumbnails.CacheSize"),
+	64,
+	TEXT("Number of game thumbnail textures kept in the AdvancedVR thumbnail cache."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarThumbnailMaxConcurrentLoads(
+	TEXT("AdvancedVR.Thumbnails.MaxConcurrentLoads"),
+	4,
+	TEXT("Number of game thumbnails read and decoded at the same time."),
+	ECVF_Default);
+
+namespace
+{
+	constexpr uint32 ThumbnailAtlasMagic = 0x54525641; // 'AVRT'
+	constexpr uint32 ThumbnailAtlasVersion = 1;
+
+	// Largest side of a thumbnail baked from an explicit texture
+	constexpr int32 ThumbnailAtlasMaxSize = 256;
+
+	TSharedPtr<FAdvancedVRThumbnailCache, ESPMode::ThreadSafe> ThumbnailCacheInstance;
+	bool bThumbnailCacheShutdown = false;
+}
+
+#if WITH_EDITOR
+static FAutoConsoleCommand BuildThumbnailAtlasCommand(
+	TEXT("AdvancedVR.Thumbnails.BuildAtlas"),
+	TEXT("Write the thumbnails of the packaged AdvancedVR games to the thumbnail atlas."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FAdvancedVRThumbnailAtlas::Build(UAdvancedVRSettings::GetPackagedGames(), FAdvancedVRThumbnailAtlas::GetFilename());
+	}));
+#endif
+
+FString FAdvancedVRThumbnailAtlas::GetFilename()
+{
+	// Generated output, staged through the RuntimeDependencies in AdvancedVR.Build.cs
+	return FPaths::Combine(FPaths::ProjectIntermediateDir(), TEXT("AdvancedVR"), TEXT("Thumbnails.avrt"));
+}
+
+bool FAdvancedVRThumbnailAtlas::ReadIndex(const FString& Filename, TArray<FEntry>& OutEntries)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename, FILEREAD_Silent));
+	if (!Reader)
+	{
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	*Reader << Magic << Version;
+	if (Magic != ThumbnailAtlasMagic || Version != ThumbnailAtlasVersion)
+	{
+		UE_LOG(LogAdvancedVR, Warning, TEXT("Ignoring thumbnail atlas %s with unknown format"), *Filename);
+		return false;
+	}
+
+	*Reader << OutEntries;
+	return !Reader->IsError();
+}
+
+bool FAdvancedVRThumbnailAtlas::DecodeEntry(IImageWrapperModule& ImageWrapperModule, const FString& Filename, const FEntry& Entry, TArray64<uint8>& OutPixels)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename, FILEREAD_Silent));
+	if (!Reader || Entry.Offset < 0 || Entry.Size <= 0 || Entry.Offset + Entry.Size > Reader->TotalSize())
+	{
+		return false;
+	}
+
+	TArray64<uint8> CompressedData;
+	CompressedData.SetNumUninitialized(Entry.Size);
+	Reader->Seek(Entry.Offset);
+	Reader->Serialize(CompressedData.GetData(), CompressedData.Num());
+	if (Reader->IsError())
+	{
+		return false;
+	}
+
+	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+	return ImageWrapper.IsValid()
+		&& ImageWrapper->SetCompressed(CompressedData.GetData(), CompressedData.Num())
+		&& ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, OutPixels);
+}
+
+#if WITH_EDITOR
+bool FAdvancedVRThumbnailAtlas::Build(const TArray<FGameBuildConfig>& Games, const FString& Filename)
+{
+	check(IsInGameThread());
+
+	const double StartTime = FPlatformTime::Seconds();
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>("ImageWrapper");
+
+	TArray<FEntry> Entries;
+	TArray<TArray64<uint8>> CompressedImages;
+	for (const FGameBuildConfig& Game : Games)
+	{
+		FEntry Entry;
+		Entry.MapName = Game.MapName;
+
+		// Explicit thumbnails are baked in as well, the cooker never sees references that only live in config
+		TArray64<uint8> Pixels;
+		const bool bLoaded = Game.Thumbnail.IsNull()
+			? LoadMapThumbnail(Game.MapPath.FilePath, Entry.Width, Entry.Height, Pixels)
+			: LoadTextureThumbnail(Game.Thumbnail, Entry.Width, Entry.Height, Pixels);
+		if (!bLoaded)
+		{
+			UE_LOG(LogAdvancedVR, Warning, TEXT("No thumbnail for map %s (%s)"), *Game.MapName,
+				Game.Thumbnail.IsNull() ? *Game.MapPath.FilePath : *Game.Thumbnail.ToString());
+			continue;
+		}
+
+		TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+		if (!ImageWrapper.IsValid() || !ImageWrapper->SetRaw(Pixels.GetData(), Pixels.Num(), Entry.Width, Entry.Height, ERGBFormat::BGRA, 8))
+		{
+			UE_LOG(LogAdvancedVR, Warning, TEXT("Failed to compress thumbnail for map %s"), *Game.MapName);
+			continue;
+		}
+
+		CompressedImages.Add(ImageWrapper->GetCompressed());
+		Entry.Size = CompressedImages.Last().Num();
+		Entries.Add(MoveTemp(Entry));
+	}
+
+	uint32 Magic = ThumbnailAtlasMagic;
+	uint32 Version = ThumbnailAtlasVersion;
+
+	// Offsets do not change the size of the entry table, so measure it first and then fill them in
+	TArray<uint8> IndexData;
+	FMemoryWriter IndexSizeWriter(IndexData);
+	IndexSizeWriter << Magic << Version << Entries;
+
+	int64 Offset = IndexData.Num();
+	for (FEntry& Entry : Entries)
+	{
+		Entry.Offset = Offset;
+		Offset += Entry.Size;
+	}
+
+	TArray<uint8> AtlasData;
+	FMemoryWriter Writer(AtlasData);
+	Writer << Magic << Version << Entries;
+	for (const TArray64<uint8>& CompressedImage : CompressedImages)
+	{
+		AtlasData.Append(CompressedImage.GetData(), CompressedImage.Num());
+	}
+
+	if (!FFileHelper::SaveArrayToFile(AtlasData, *Filename))
+	{
+		UE_LOG(LogAdvancedVR, Error, TEXT("Failed to write thumbnail atlas %s"), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogAdvancedVR, Log, TEXT("Wrote %d of %d thumbnails to %s (%d KB) in %.2f ms"),
+		Entries.Num(), Games.Num(), *Filename, AtlasData.Num() / 1024, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return true;
+}
+
+bool FAdvancedVRThumbnailAtlas::LoadTextureThumbnail(const TSoftObjectPtr<UTexture2D>& Thumbnail, int32& OutWidth, int32& OutHeight, TArray64<uint8>& OutPixels)
+{
+	check(IsInGameThread());
+
+	UTexture2D* Texture = Thumbnail.LoadSynchronous();
+	FImage SourceImage;
+	if (!Texture || !Texture->Source.IsValid() || !Texture->Source.GetMipImage(SourceImage, 0))
+	{
+		return false;
+	}
+
+	// Textures picked as thumbnails are often full size, keep the atlas small
+	FImage Image;
+	const float Scale = FMath::Min(1.0f, float(ThumbnailAtlasMaxSize) / FMath::Max(SourceImage.SizeX, SourceImage.SizeY));
+	if (Scale < 1.0f)
+	{
+		SourceImage.ResizeTo(Image, FMath::Max(FMath::RoundToInt(SourceImage.SizeX * Scale), 1), FMath::Max(FMath::RoundToInt(SourceImage.SizeY * Scale), 1), ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+	}
+	else
+	{
+		SourceImage.CopyTo(Image, ERawImageFormat::BGRA8, EGammaSpace::sRGB);
+	}
+
+	OutWidth = Image.SizeX;
+	OutHeight = Image.SizeY;
+	OutPixels = MoveTemp(Image.RawData);
+	return OutPixels.Num() == int64(OutWidth) * OutHeight * 4;
+}
+
+bool FAdvancedVRThumbnailAtlas::LoadMapThumbnail(const FString& MapPath, int32& OutWidth, int32& OutHeight, TArray64<uint8>& OutPixels)
+{
+	const FString PackageName = FPackageName::ObjectPathToPackageName(MapPath);
+	FString PackageFilename;
+	if (PackageName.IsEmpty() || !FPackageName::TryConvertLongPackageNameToFilename(PackageName, PackageFilename, FPackageName::GetMapPackageExtension()))
+	{
+		return false;
+	}
+
+	// Only the thumbnail table of the package is read, the map itself is not loaded
+	const FName ObjectFullName(*FString::Printf(TEXT("World %s.%s"), *PackageName, *FPackageName::GetShortName(PackageName)));
+	TSet<FName> ObjectFullNames;
+	ObjectFullNames.Add(ObjectFullName);
+
+	FThumbnailMap Thumbnails;
+	if (!ThumbnailTools::LoadThumbnailsFromPackage(PackageFilename, ObjectFullNames, Thumbnails))
+	{
+		return false;
+	}
+
+	const FObjectThumbnail* Thumbnail = Thumbnails.Find(ObjectFullName);
+	if (!Thumbnail || Thumbnail->IsEmpty())
+	{
+		return false;
+	}
+
+	const TArray<uint8>& ImageData = Thumbnail->GetUncompressedImageData();
+	OutWidth = Thumbnail->GetImageWidth();
+	OutHeight = Thumbnail->GetImageHeight();
+	OutPixels.Reset(ImageData.Num());
+	OutPixels.Append(ImageData.GetData(), ImageData.Num());
+	return OutPixels.Num() == int64(OutWidth) * OutHeight * 4;
+}
+#endif
+
+FAdvancedVRThumbnailCache* FAdvancedVRThumbnailCache::Get()
+{
+	check(IsInGameThread());
+
+	if (!ThumbnailCacheInstance.IsValid() && !bThumbnailCacheShutdown && !IsRunningCommandlet())
+	{
+		ThumbnailCacheInstance = MakeShared<FAdvancedVRThumbnailCache, ESPMode::ThreadSafe>();
+	}
+	return ThumbnailCacheInstance.Get();
+}
+
+void FAdvancedVRThumbnailCache::Shutdown()
+{
+	ThumbnailCacheInstance.Reset();
+	bThumbnailCacheShutdown = true;
+}
+
+FAdvancedVRThumbnailCache::FAdvancedVRThumbnailCache()
+{
+	// Modules can only be loaded on the game thread, the decode jobs use this pointer
+	ImageWrapperModule = &FModuleManager::LoadModuleChecked<IImageWrapperModule>("ImageWrapper");
+	SettingsChangedHandle = UAdvancedVRSettings::OnSettingsChanged.AddRaw(this, &FAdvancedVRThumbnailCache::OnSettingsChanged);
+#if WITH_EDITOR
+	PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddRaw(this, &FAdvancedVRThumbnailCache::OnPackageSaved);
+#endif
+}
+
+FAdvancedVRThumbnailCache::~FAdvancedVRThumbnailCache()
+{
+	UAdvancedVRSettings::OnSettingsChanged.Remove(SettingsChangedHandle);
+#if WITH_EDITOR
+	UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+#endif
+}
+
+UTexture2D* FAdvancedVRThumbnailCache::FindOrRequest(const FString& MapName)
+{
+	check(IsInGameThread());
+
+	if (FCachedThumbnail* CachedThumbnail = Cache.Find(MapName))
+	{
+		CachedThumbnail->LastUsed = ++UseCounter;
+		return CachedThumbnail->Texture;
+	}
+
+	if (MapName.IsEmpty() || MissingThumbnails.Contains(MapName) || InFlightRequests.Contains(MapName))
+	{
+		return nullptr;
+	}
+
+	// Move the request to the end, so rows that just scrolled into view are loaded first
+	PendingRequests.Remove(MapName);
+	PendingRequests.Add(MapName);
+
+	// Rows scrolled out of view long ago are not worth loading anymore
+	const int32 MaxPendingRequests = FMath::Max(CVarThumbnailCacheSize.GetValueOnGameThread(), 1);
+	if (PendingRequests.Num() > MaxPendingRequests)
+	{
+		TArray<FString> DroppedRequests(PendingRequests.GetData(), PendingRequests.Num() - MaxPendingRequests);
+		PendingRequests.RemoveAt(0, DroppedRequests.Num());
+		for (const FString& DroppedRequest : DroppedRequests)
+		{
+			OnThumbnailReady.Broadcast(DroppedRequest, nullptr);
+		}
+	}
+
+	PumpRequests();
+	return nullptr;
+}
+
+void FAdvancedVRThumbnailCache::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (TPair<FString, FCachedThumbnail>& Pair : Cache)
+	{
+		Collector.AddReferencedObject(Pair.Value.Texture);
+	}
+}
+
+FString FAdvancedVRThumbnailCache::GetReferencerName() const
+{
+	return TEXT("FAdvancedVRThumbnailCache");
+}
+
+void FAdvancedVRThumbnailCache::OnSettingsChanged(EAdvancedVRSettingsChange Changes, const FAdvancedVRSettingsSnapshotRef& Snapshot)
+{
+	if (EnumHasAnyFlags(Changes, EAdvancedVRSettingsChange::AllGameMaps))
+	{
+		Reset();
+	}
+}
+
+#if WITH_EDITOR
+void FAdvancedVRThumbnailCache::OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext ObjectSaveContext)
+{
+	const FString PackageName = Package->GetName();
+	for (const FGameBuildConfig& Game : UAdvancedVRSettings::GetSnapshot()->AllGames)
+	{
+		if (FPackageName::ObjectPathToPackageName(Game.MapPath.FilePath) == PackageName || Game.Thumbnail.GetLongPackageName() == PackageName)
+		{
+			// Saving writes the thumbnail the map may have been missing, or changes the one in the cache
+			MissingThumbnails.Remove(Game.MapName);
+			Cache.Remove(Game.MapName);
+		}
+	}
+}
+#endif
+
+void FAdvancedVRThumbnailCache::Reset()
+{
+	++Generation;
+	Cache.Empty();
+
+	// Results of the loads in flight are dropped, so load them again with the new settings
+	for (const FString& InFlightRequest : InFlightRequests)
+	{
+		PendingRequests.AddUnique(InFlightRequest);
+	}
+	InFlightRequests.Empty();
+	MissingThumbnails.Empty();
+	AtlasEntries.Empty();
+	bIndexRequested = false;
+	bIndexLoaded = false;
+
+	if (PendingRequests.Num() > 0)
+	{
+		PumpRequests();
+	}
+}
+
+void FAdvancedVRThumbnailCache::LoadIndexAsync()
+{
+	if (bIndexRequested)
+	{
+		return;
+	}
+	bIndexRequested = true;
+
+	TWeakPtr<FAdvancedVRThumbnailCache, ESPMode::ThreadSafe> WeakThis = AsShared();
+	const uint32 RequestGeneration = Generation;
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis, RequestGeneration]()
+	{
+		TArray<FAdvancedVRThumbnailAtlas::FEntry> Entries;
+		FAdvancedVRThumbnailAtlas::ReadIndex(FAdvancedVRThumbnailAtlas::GetFilename(), Entries);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, RequestGeneration, Entries = MoveTemp(Entries)]()
+		{
+			TSharedPtr<FAdvancedVRThumbnailCache, ESPMode::ThreadSafe> This = WeakThis.Pin();
+			if (!This.IsValid() || This->Generation != RequestGeneration)
+			{
+				return;
+			}
+
+			for (const FAdvancedVRThumbnailAtlas::FEntry& Entry : Entries)
+			{
+				This->AtlasEntries.Add(Entry.MapName, Entry);
+			}
+			This->bIndexLoaded = true;
+			This->PumpRequests();
+		});
+	});
+}
+
+void FAdvancedVRThumbnailCache::PumpRequests()
+{
+	if (!bIndexLoaded)
+	{
+		LoadIndexAsync();
+		return;
+	}
+
+	const int32 MaxConcurrentLoads = FMath::Max(CVarThumbnailMaxConcurrentLoads.GetValueOnGameThread(), 1);
+	while (InFlightRequests.Num() < MaxConcurrentLoads && PendingRequests.Num() > 0)
+	{
+		StartRequest(PendingRequests.Pop());
+	}
+}
+
+void FAdvancedVRThumbnailCache::StartRequest(const FString& MapName)
+{
+	InFlightRequests.Add(MapName);
+
+	const FAdvancedVRSettingsSnapshotRef Snapshot = UAdvancedVRSettings::GetSnapshot();
+	const FGameBuildConfig* Game = Snapshot->AllGames.FindByPredicate([&MapName](const FGameBuildConfig& Config) { return Config.MapName == MapName; });
+
+	TWeakPtr<FAdvancedVRThumbnailCache, ESPMode::ThreadSafe> WeakThis = AsShared();
+	const uint32 RequestGeneration = Generation;
+
+	// The editor reads the thumbnail sources directly so the picker never shows a stale atlas.
+	// Packaged games only have the atlas, explicit thumbnails are baked into it at cook time.
+	FString MapPath;
+#if WITH_EDITOR
+	if (GIsEditor && Game)
+	{
+		// An explicit thumbnail texture wins over the map's saved thumbnail
+		if (!Game->Thumbnail.IsNull())
+		{
+			const FSoftObjectPath TexturePath = Game->Thumbnail.ToSoftObjectPath();
+			StreamableManager.RequestAsyncLoad(TexturePath, [WeakThis, RequestGeneration, MapName, TexturePath]()
+			{
+				if (TSharedPtr<FAdvancedVRThumbnailCache, ESPMode::ThreadSafe> This = WeakThis.Pin())
+				{
+					This->OnTextureLoaded(RequestGeneration, MapName, TexturePath);
+				}
+			});
+			return;
+		}
+
+		MapPath = Game->MapPath.FilePath;
+	}
+#endif
+
+	const FAdvancedVRThumbnailAtlas::FEntry* AtlasEntry = AtlasEntries.Find(MapName);
+	if (MapPath.IsEmpty() && !AtlasEntry)
+	{
+		FinishRequest(MapName, nullptr);
+		return;
+	}
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis, RequestGeneration, MapName, MapPath, Entry = AtlasEntry ? *AtlasEntry : FAdvancedVRThumbnailAtlas::FEntry(), ImageWrapperModule = ImageWrapperModule]()
+	{
+		LLM_SCOPE_BYTAG(AdvancedVR_Thumbnails);
+
+		int32 Width = Entry.Width;
+		int32 Height = Entry.Height;
+		TArray64<uint8> Pixels;
+
+#if WITH_EDITOR
+		if (!MapPath.IsEmpty())
+		{
+			FAdvancedVRThumbnailAtlas::LoadMapThumbnail(MapPath, Width, Height, Pixels);
+		}
+		else
+#endif
+		{
+			FAdvancedVRThumbnailAtlas::DecodeEntry(*ImageWrapperModule, FAdvancedVRThumbnailAtlas::GetFilename(), Entry, Pixels);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, RequestGeneration, MapName, Width, Height, Pixels = MoveTemp(Pixels)]() mutable
+		{
+			if (TSharedPtr<FAdvancedVRThumbnailCache, ESPMode::ThreadSafe> This = WeakThis.Pin())
+			{
+				This->OnDecoded(RequestGeneration, MapName, Width, Height, MoveTemp(Pixels));
+			}
+		});
+	});
+}
+
+void FAdvancedVRThumbnailCache::OnDecoded(uint32 RequestGeneration, const FString& MapName, int32 Width, int32 Height, TArray64<uint8>&& Pixels)
+{
+	if (RequestGeneration != Generation)
+	{
+		return;
+	}
+
+	LLM_SCOPE_BYTAG(AdvancedVR_Thumbnails);
+
+	UTexture2D* Texture = nullptr;
+	if (Width > 0 && Height > 0 && Pixels.Num() == int64(Width) * Height * 4)
+	{
+		Texture = UTexture2D::CreateTransient(Width, Height, PF_B8G8R8A8);
+	}
+
+	if (Texture)
+	{
+		FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+		FMemory::Memcpy(Mip.BulkData.Lock(LOCK_READ_WRITE), Pixels.GetData(), Pixels.Num());
+		Mip.BulkData.Unlock();
+		Texture->UpdateResource();
+	}
+
+	FinishRequest(MapName, Texture);
+}
+
+void FAdvancedVRThumbnailCache::OnTextureLoaded(uint32 RequestGeneration, const FString& MapName, const FSoftObjectPath& TexturePath)
+{
+	if (RequestGeneration != Generation)
+	{
+		return;
+	}
+
+	FinishRequest(MapName, Cast<UTexture2D>(TexturePath.ResolveObject()));
+}
+
+void FAdvancedVRThumbnailCache::FinishRequest(const FString& MapName, UTexture2D* Texture)
+{
+	LLM_SCOPE_BYTAG(AdvancedVR_Thumbnails);
+
+	InFlightRequests.Remove(MapName);
+
+	if (!Texture)
+	{
+		UE_LOG(LogAdvancedVR, Verbose, TEXT("No thumbnail for map %s"), *MapName);
+		MissingThumbnails.Add(MapName);
+		OnThumbnailReady.Broadcast(MapName, nullptr);
+		PumpRequests();
+		return;
+	}
+
+	// Evict the least recently used thumbnails
+	const int32 CacheSize = FMath::Max(CVarThumbnailCacheSize.GetValueOnGameThread(), 1);
+	while (Cache.Num() >= CacheSize)
+	{
+		const FString* LeastRecentlyUsed = nullptr;
+		uint64 LeastRecentUse = MAX_uint64;
+		for (const TPair<FString, FCachedThumbnail>& Pair : Cache)
+		{
+			if (Pair.Value.LastUsed < LeastRecentUse)
+			{
+				LeastRecentlyUsed = &Pair.Key;
+				LeastRecentUse = Pair.Value.LastUsed;
+			}
+		}
+		Cache.Remove(FString(*LeastRecentlyUsed));
+	}
+
+	Cache.Add(MapName, { Texture, ++UseCounter });
+	OnThumbnailReady.Broadcast(MapName, Texture);
+
+	PumpRequests();
+}
@@ -4,6 +4,15 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "HAL/LowLevelMemTracker.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogAdvancedVR, Log, All);
+
+// Low Level Memory tracker tags for memory owned by the plugin itself
+LLM_DECLARE_TAG_API(AdvancedVR, ADVANCEDVR_API);
+LLM_DECLARE_TAG_API(AdvancedVR_Settings, ADVANCEDVR_API);
+LLM_DECLARE_TAG_API(AdvancedVR_MemoryTracker, ADVANCEDVR_API);
+LLM_DECLARE_TAG_API(AdvancedVR_Thumbnails, ADVANCEDVR_API);
 
 class FAdvancedVRModule : public IModuleInterface
 {
@@ -13,4 +22,18 @@ public:
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
 
+private:
+
+	/** Deferred setup that is not needed before the engine is fully initialized */
+	void OnPostEngineInit();
+
+#if WITH_EDITOR
+	/** Registers the details customization, only when an interactive editor will show it */
+	void RegisterEditorCustomization();
+
+	/** Whether the details customization was registered with the PropertyEditor module */
+	bool bCustomizationRegistered = false;
+#endif
+
+	FDelegateHandle PostEngineInitHandle;
 };
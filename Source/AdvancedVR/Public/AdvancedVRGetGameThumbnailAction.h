@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "AdvancedVRGetGameThumbnailAction.generated.h"
+
+class FAdvancedVRThumbnailCache;
+class UTexture2D;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FAdvancedVRGameThumbnailDelegate, UTexture2D*, Thumbnail);
+
+/**
+ * Blueprint async node that waits for the thumbnail of a game, so a lobby can fill its rows without polling
+ * UAdvancedVRSettings::GetGameThumbnail every tick.
+ */
+UCLASS()
+class ADVANCEDVR_API UAdvancedVRGetGameThumbnailAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	// Get Thumbnail of a Game (Map Name). Completed fires once it is loaded, right away if it is already cached
+	UFUNCTION(BlueprintCallable, Category = "AdvancedVRSettings", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject"))
+	static UAdvancedVRGetGameThumbnailAction* GetGameThumbnailAsync(UObject* WorldContextObject, const FString& MapName);
+
+	UPROPERTY(BlueprintAssignable)
+	FAdvancedVRGameThumbnailDelegate Completed;
+
+	// The game has no thumbnail, or thumbnails are not available (commandlets, shutdown)
+	UPROPERTY(BlueprintAssignable)
+	FAdvancedVRGameThumbnailDelegate Failed;
+
+	//~ Begin UBlueprintAsyncActionBase Interface
+	virtual void Activate() override;
+	virtual void SetReadyToDestroy() override;
+	//~ End UBlueprintAsyncActionBase Interface
+
+private:
+	void Request();
+	void OnThumbnailReady(const FString& ReadyMapName, UTexture2D* Thumbnail);
+	void Finish(UTexture2D* Thumbnail);
+
+	FString MapName;
+
+	// Set when the request was dropped for newer ones, requested again once another thumbnail frees a slot
+	bool bWaitingForSlot = false;
+	bool bFinished = false;
+
+	TWeakPtr<FAdvancedVRThumbnailCache, ESPMode::ThreadSafe> ThumbnailCache;
+	FDelegateHandle ThumbnailReadyHandle;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "UObject/ObjectKey.h"
+
+#define WITH_ADVANCEDVR_MEMORY_TRACKER !UE_BUILD_SHIPPING
+
+#if WITH_ADVANCEDVR_MEMORY_TRACKER
+
+class UWorld;
+
+/**
+ * Memory attributed to one FGameBuildConfig.
+ * Only textures, meshes and sound waves are sized, counting the mips and LODs that are currently streamed in.
+ * Other assets (animations, materials, blueprints) are not included in TrackedBytes.
+ */
+struct FAdvancedVRGameMemory
+{
+	// MapName of the game, empty for memory loaded outside of any game map
+	FString MapName;
+
+	int32 NumPackages = 0;
+	int32 NumTextures = 0;
+	int32 NumMeshes = 0;
+	int32 NumSounds = 0;
+
+	int64 TextureBytes = 0;
+	int64 MeshBytes = 0;
+	int64 SoundBytes = 0;
+
+	// Highest tracked size seen since the tracker started
+	int64 PeakTrackedBytes = 0;
+
+	int64 GetTrackedBytes() const { return TextureBytes + MeshBytes + SoundBytes; }
+};
+
+/**
+ * Opt-in runtime tracker that attributes loaded packages, textures, meshes and sounds to the game whose map
+ * was being loaded or played when they first appeared. Assets already resident when a game starts
+ * stay with the game that loaded them first. Assets resident when the tracker starts go to the game map
+ * that is currently playing, if any.
+ *
+ * Enable with AdvancedVR.MemoryTracker.Enable 1, report with AdvancedVR.MemoryTracker.Report and
+ * AdvancedVR.MemoryTracker.ExportCsv [Filename].
+ */
+class ADVANCEDVR_API FAdvancedVRMemoryTracker
+{
+public:
+	static FAdvancedVRMemoryTracker& Get();
+
+	// Does nothing in commandlets
+	void Start();
+	void Stop();
+	bool IsRunning() const { return bRunning; }
+
+	// Walk the loaded objects and refresh the per-game totals. Game thread only.
+	void Sample();
+
+	void LogReport() const;
+	bool ExportCsv(const FString& Filename) const;
+
+	const TArray<FAdvancedVRGameMemory>& GetGameMemory() const { return GameMemory; }
+
+private:
+	void OnPreLoadMap(const FString& MapName);
+	void OnPostLoadMapWithWorld(UWorld* World);
+	bool Tick(float DeltaTime);
+
+	// Index in GameMemory of the game that owns the map package, 0 if it is not a game map
+	int32 FindOrAddGameForMap(const FString& MapPackageName);
+
+	// Index 0 holds memory that does not belong to any game
+	TArray<FAdvancedVRGameMemory> GameMemory;
+
+	// Game index that each tracked object was first seen under
+	TMap<FObjectKey, int32> Attribution;
+
+	int32 CurrentGameIndex = 0;
+	bool bRunning = false;
+
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+	FTSTicker::FDelegateHandle TickerHandle;
+};
+
+#endif // WITH_ADVANCEDVR_MEMORY_TRACKER
@@ -4,6 +4,8 @@
 #include "UObject/SoftObjectPtr.h"
 #include "AdvancedVRSettings.generated.h"
 
+class UTexture2D;
+
 DECLARE_LOG_CATEGORY_EXTERN(LogAdvancedVRSettings, Log, All);
 
 DECLARE_MULTICAST_DELEGATE(FOnSettingsUpdated);
@@ -36,6 +38,9 @@ struct FGameBuildConfig
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game Config", meta = (ToolTip = "Map's FilePath", RelativeToGameContentDir, LongPackageName))
 	FFilePath MapPath;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game Config", meta = (ToolTip = "Optional Thumbnail, the map's saved thumbnail is used when empty"))
+	TSoftObjectPtr<UTexture2D> Thumbnail;
+
 	/*UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game Config", meta = (ToolTip = "Enabled by Default"))
 	bool bDefault = false;*/
 };
@@ -44,6 +49,23 @@ struct FGameBuildConfig
 typedef TSharedPtr<FGameBuildConfig, ESPMode::ThreadSafe> FGameBuildConfigPtr;
 typedef TSharedRef<FGameBuildConfig, ESPMode::ThreadSafe> FGameBuildConfigRef;
 
+// Immutable settings snapshot, see AdvancedVRSettingsSnapshot.h
+class FAdvancedVRSettingsSnapshot;
+typedef TSharedRef<const FAdvancedVRSettingsSnapshot, ESPMode::ThreadSafe> FAdvancedVRSettingsSnapshotRef;
+
+// Settings that changed in one update, see UAdvancedVRSettings::OnSettingsChanged
+enum class EAdvancedVRSettingsChange : uint8
+{
+	None				= 0,
+	PlatformType		= 1 << 0,
+	XRComponentClass	= 1 << 1,
+	AllGameMaps			= 1 << 2,
+	MapsToPackage		= 1 << 3
+};
+ENUM_CLASS_FLAGS(EAdvancedVRSettingsChange);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnAdvancedVRSettingsChanged, EAdvancedVRSettingsChange /*Changes*/, const FAdvancedVRSettingsSnapshotRef& /*Snapshot*/);
+
 UCLASS(config = Engine, defaultconfig)
 class ADVANCEDVR_API UAdvancedVRSettings : public UObject
 {
@@ -95,10 +117,25 @@ public:
 	UFUNCTION(BlueprintPure, Category = "AdvancedVRSettings")
 	static TArray<FString> GetPackagedMapNames();
 
+	// Get Thumbnail of a Game (Map Name). Returns None while it is still loading, use Get Game Thumbnail Async to wait for it
+	UFUNCTION(BlueprintCallable, Category = "AdvancedVRSettings")
+	static UTexture2D* GetGameThumbnail(const FString& MapName);
+
+	// Get the latest published settings snapshot. Lock-free and safe to call from any thread.
+	static FAdvancedVRSettingsSnapshotRef GetSnapshot();
+
 	virtual void PostInitProperties() override;
+	virtual void PostReloadConfig(FProperty* PropertyThatWasLoaded) override;
 
 	static FOnSettingsUpdated OnSettingsUpdated;
 
+	// Broadcast on the game thread after an edit or a live reload, with the snapshot that contains the new values
+	static FOnAdvancedVRSettingsChanged OnSettingsChanged;
+
+	// Re-read the settings from the full Engine config hierarchy with OverrideFilename combined on top, apply the
+	// values that differ and broadcast OnSettingsChanged. Call on the CDO from the game thread.
+	EAdvancedVRSettingsChange ReloadConfigWithOverride(const FString& OverrideFilename);
+
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
@@ -107,6 +144,15 @@ public:
 	void SyncMapsToCook();
 
 private:
+	// Set the config properties to their constructor values
+	void ResetConfigToDefaults();
+
+	// Publish a new snapshot of the CDO values. Game thread only.
+	void PublishSnapshot();
+
+	// Copy the config values of Source that differ from this object, then publish and broadcast them
+	EAdvancedVRSettingsChange ApplySettingsFrom(const UAdvancedVRSettings& Source);
+
 	// Get Game Build Config By MapName
 	static bool GetGameBuildConfigByMapName(const UAdvancedVRSettings* AdvancedVRSettings,const FString& MapName, FGameBuildConfig& GameBuildConfig);
 };
@@ -3,11 +3,14 @@
 #include "CoreMinimal.h"
 #include "IDetailCustomization.h"
 #include "AdvancedVRSettings.h"
+#include "AdvancedVRThumbnailCache.h"
+#include "Engine/Texture2D.h"
 #include "DetailLayoutBuilder.h"
 #include "DetailCategoryBuilder.h"
 #include "DetailWidgetRow.h"
 #include "PropertyHandle.h"
 #include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Layout/SBox.h"
 #include "Widgets/Text/STextBlock.h"
 #include "Widgets/Views/SMultipleOptionTable.h"
 
@@ -38,6 +41,20 @@ public:
 							.ToolTipText(LOCTEXT("FilePathEmpty", "FilePath Is Empty!"))
 					]
 					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.Padding(FMargin(3.0, 2.0))
+					.VAlign(VAlign_Center)
+					[
+						// Thumbnail is loaded asynchronously, keep its space reserved until it arrives
+						SNew(SBox)
+							.WidthOverride(ThumbnailSize)
+							.HeightOverride(ThumbnailSize)
+							[
+								SNew(SImage)
+									.Image(this, &SMapPickerRowWidget::GetThumbnailBrush)
+							]
+					]
+					+ SHorizontalBox::Slot()
 					.FillWidth(1.0f)
 					.VAlign(VAlign_Center)
 					[
@@ -53,8 +70,26 @@ public:
         return GameBuildConfig->MapPath.FilePath.IsEmpty() ? EVisibility::Visible : EVisibility::Collapsed;
     }
 
+    const FSlateBrush* GetThumbnailBrush() const
+    {
+        // Asked every paint, so an evicted thumbnail is requested again and never drawn after eviction
+        FAdvancedVRThumbnailCache* ThumbnailCache = FAdvancedVRThumbnailCache::Get();
+        UTexture2D* Thumbnail = ThumbnailCache ? ThumbnailCache->FindOrRequest(GameBuildConfig->MapName) : nullptr;
+        if (!Thumbnail)
+        {
+            return nullptr;
+        }
+
+        ThumbnailBrush.SetResourceObject(Thumbnail);
+        ThumbnailBrush.ImageSize = FVector2D(ThumbnailSize, ThumbnailSize);
+        return &ThumbnailBrush;
+    }
+
 private:
+    static constexpr float ThumbnailSize = 48.0f;
+
     FGameBuildConfigPtr GameBuildConfig;
+    mutable FSlateBrush ThumbnailBrush;
 };
 
 /**
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+#define WITH_ADVANCEDVR_SETTINGS_RELOAD !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+#if WITH_ADVANCEDVR_SETTINGS_RELOAD
+
+/**
+ * Development-only live reload of UAdvancedVRSettings.
+ * Polls the settings' default config file and an override file, and when either is written rebuilds the Engine
+ * config hierarchy with the override on top through UAdvancedVRSettings::ReloadConfigWithOverride, which
+ * broadcasts UAdvancedVRSettings::OnSettingsChanged.
+ *
+ * The override file uses the same [/Script/AdvancedVR.AdvancedVRSettings] section and array operators as the
+ * default config and defaults to Saved/Config/AdvancedVROverride.ini, so it can be pushed to a device without
+ * repackaging.
+ *
+ * Off by default so a stale override left on a device never replaces the packaged settings. Enable with
+ * -AdvancedVRSettingsReload on the command line or AdvancedVR.SettingsReload.Enable 1.
+ */
+class ADVANCEDVR_API FAdvancedVRSettingsReloader
+{
+public:
+	static FAdvancedVRSettingsReloader& Get();
+
+	// Does nothing in the editor and in commandlets
+	void Start();
+	void Stop();
+	bool IsRunning() const { return bRunning; }
+
+	// Re-read the watched files now, whether or not they changed
+	void ReloadNow();
+
+	static FString GetOverrideFilename();
+
+private:
+	bool Tick(float DeltaTime);
+
+	struct FWatchedFile
+	{
+		FString Filename;
+		FDateTime TimeStamp;
+	};
+
+	TArray<FWatchedFile> WatchedFiles;
+	bool bRunning = false;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+};
+
+#endif // WITH_ADVANCEDVR_SETTINGS_RELOAD
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AdvancedVRSettings.h"
+#include "UObject/SoftObjectPath.h"
+
+/**
+ * Immutable copy of UAdvancedVRSettings taken on the game thread.
+ * A new snapshot is published every time the settings change, so it can be read from any thread
+ * (async loading callbacks, task graph jobs, background threads) without touching the CDO.
+ */
+class ADVANCEDVR_API FAdvancedVRSettingsSnapshot : public TSharedFromThis<FAdvancedVRSettingsSnapshot, ESPMode::ThreadSafe>
+{
+public:
+	// Build a snapshot from the current values of Settings. Game thread only.
+	static FAdvancedVRSettingsSnapshotRef Create(const UAdvancedVRSettings& Settings);
+
+	// Snapshot used before the settings CDO has published anything
+	static FAdvancedVRSettingsSnapshotRef GetEmpty();
+
+	// Whether this snapshot already holds the current values of Settings. Game thread only.
+	bool Matches(const UAdvancedVRSettings& Settings) const;
+
+	// Increases with every published snapshot, 0 for the empty one
+	uint32 Version = 0;
+
+	EPlatformType PlatformType = EPlatformType::Unknown;
+
+	// Resolved path of XRComponentClass, safe to pass to any thread
+	FSoftClassPath XRComponentClassPath;
+
+	TArray<FGameBuildConfig> AllGames;
+	TArray<FString> AllMapNames;
+
+	// Entries of AllGames referenced by MapsToPackage, in MapsToPackage order
+	TArray<FGameBuildConfig> PackagedGames;
+	TArray<FString> PackagedMapNames;
+};
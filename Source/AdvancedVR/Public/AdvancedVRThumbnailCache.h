@@ -0,0 +1,132 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AdvancedVRSettings.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/GCObject.h"
+
+class FObjectPostSaveContext;
+class IImageWrapperModule;
+class UPackage;
+class UTexture2D;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnAdvancedVRThumbnailReady, const FString& /*MapName*/, UTexture2D* /*Thumbnail*/);
+
+/**
+ * Compressed thumbnail atlas: a single file with an entry table followed by one PNG per game.
+ * Written headlessly at cook time from each game's explicit thumbnail texture or its map's saved asset thumbnail,
+ * and read by FAdvancedVRThumbnailCache in packaged games.
+ */
+struct ADVANCEDVR_API FAdvancedVRThumbnailAtlas
+{
+	struct FEntry
+	{
+		FString MapName;
+		int32 Width = 0;
+		int32 Height = 0;
+		int64 Offset = 0;
+		int64 Size = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FEntry& Entry)
+		{
+			return Ar << Entry.MapName << Entry.Width << Entry.Height << Entry.Offset << Entry.Size;
+		}
+	};
+
+	// Intermediate/AdvancedVR/Thumbnails.avrt, staged with the packaged game
+	static FString GetFilename();
+
+	// Read the entry table of an atlas file. Safe to call from worker threads.
+	static bool ReadIndex(const FString& Filename, TArray<FEntry>& OutEntries);
+
+	// Read and decode one entry to BGRA pixels. Safe to call from worker threads.
+	static bool DecodeEntry(IImageWrapperModule& ImageWrapperModule, const FString& Filename, const FEntry& Entry, TArray64<uint8>& OutPixels);
+
+#if WITH_EDITOR
+	// Write the thumbnails of the games to an atlas file, nothing is rendered. Game thread only.
+	static bool Build(const TArray<FGameBuildConfig>& Games, const FString& Filename);
+
+	// Load a thumbnail texture and read its source as BGRA pixels, scaled down to at most 256 pixels. Game thread only.
+	static bool LoadTextureThumbnail(const TSoftObjectPtr<UTexture2D>& Thumbnail, int32& OutWidth, int32& OutHeight, TArray64<uint8>& OutPixels);
+
+	// Read the saved thumbnail of a map package as BGRA pixels. Safe to call from worker threads.
+	static bool LoadMapThumbnail(const FString& MapPath, int32& OutWidth, int32& OutHeight, TArray64<uint8>& OutPixels);
+#endif
+};
+
+/**
+ * LRU cache of game thumbnail textures shared by the editor map picker and the runtime lobby.
+ * Thumbnails are read and decoded on worker threads, only the texture upload happens on the game thread,
+ * so asking for a thumbnail never blocks. The most recently requested maps are loaded first.
+ */
+class ADVANCEDVR_API FAdvancedVRThumbnailCache : public FGCObject, public TSharedFromThis<FAdvancedVRThumbnailCache, ESPMode::ThreadSafe>
+{
+public:
+	// Created on first use from the game thread, nullptr in commandlets and after Shutdown
+	static FAdvancedVRThumbnailCache* Get();
+	static void Shutdown();
+
+	FAdvancedVRThumbnailCache();
+	virtual ~FAdvancedVRThumbnailCache();
+
+	// Cached thumbnail of the game, or nullptr after queueing it for loading. Game thread only.
+	UTexture2D* FindOrRequest(const FString& MapName);
+
+	// Whether the game is known to have no thumbnail. FindOrRequest does not request it again.
+	bool IsMissing(const FString& MapName) const { return MissingThumbnails.Contains(MapName); }
+
+	// Broadcast on the game thread once for every request, with the thumbnail when it enters the cache.
+	// Thumbnail is nullptr when the game has none (IsMissing) or when the request was dropped to make room for newer ones.
+	FOnAdvancedVRThumbnailReady OnThumbnailReady;
+
+	//~ Begin FGCObject Interface
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+	//~ End FGCObject Interface
+
+private:
+	struct FCachedThumbnail
+	{
+		TObjectPtr<UTexture2D> Texture;
+		uint64 LastUsed = 0;
+	};
+
+	void OnSettingsChanged(EAdvancedVRSettingsChange Changes, const FAdvancedVRSettingsSnapshotRef& Snapshot);
+	void Reset();
+
+#if WITH_EDITOR
+	// Drops misses and cached thumbnails of a game whose map or thumbnail texture was saved
+	void OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext ObjectSaveContext);
+#endif
+
+	void LoadIndexAsync();
+	void PumpRequests();
+	void StartRequest(const FString& MapName);
+	void OnDecoded(uint32 RequestGeneration, const FString& MapName, int32 Width, int32 Height, TArray64<uint8>&& Pixels);
+	void OnTextureLoaded(uint32 RequestGeneration, const FString& MapName, const FSoftObjectPath& TexturePath);
+	void FinishRequest(const FString& MapName, UTexture2D* Texture);
+
+	TMap<FString, FCachedThumbnail> Cache;
+	uint64 UseCounter = 0;
+
+	// Waiting requests, the most recent one at the end
+	TArray<FString> PendingRequests;
+	TSet<FString> InFlightRequests;
+
+	// Maps without any thumbnail, not requested again until the settings change or, in the editor, the map is saved
+	TSet<FString> MissingThumbnails;
+
+	TMap<FString, FAdvancedVRThumbnailAtlas::FEntry> AtlasEntries;
+	bool bIndexRequested = false;
+	bool bIndexLoaded = false;
+
+	// Increased on Reset, so results of older requests are dropped
+	uint32 Generation = 0;
+
+	FStreamableManager StreamableManager;
+	IImageWrapperModule* ImageWrapperModule = nullptr;
+	FDelegateHandle SettingsChangedHandle;
+#if WITH_EDITOR
+	FDelegateHandle PackageSavedHandle;
+#endif
+};